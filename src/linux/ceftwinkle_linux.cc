@@ -25,6 +25,7 @@
 #include <sys/types.h>
 #include <gtk/gtk.h>
 #include "twinkle_app.h"
+#include "twinkle_dirs.h"
 #include "twk.h"
 
 #include "include/base/cef_logging.h"
@@ -49,54 +50,17 @@ int XIOErrorHandlerImpl(Display* display) {
 }  // namespace
 
 
-static int mkpath(char *path, mode_t mode)
-{
-  char *p = path;
-  while (p&&*p) {
-    p = strchr(p+1, '/');
-    if (p) *p = 0;
-    if (mkdir(path, mode) == -1) {
-      if (errno != EEXIST) {
-	if (p) *p = '/';
-	return -1;
-      }
-    }
-    if (p) {
-      *p++ = '/';
-    }
-  }
-  return 0;
-}
-
 static char cef_cache_path[1024];
 
-static int init_dirs()
+// See twinkle_dirs.h, and the cache of CEF
+static void init_dirs()
 {
-	char buf[1024];
-
-	int n = readlink("/proc/self/exe", buf, sizeof(buf));
-	assert(n > 0);
-	if (n >= sizeof(buf) || n < 0)
-	  exit(-1);
-	buf[n] = 0;
-	*strrchr(buf,'/')=0;
-	printf("dist:%s\n", buf);
-	twk_set_dist_path(buf);
-	
-	snprintf(buf, sizeof(buf), "%s/.config/twinkle/run", getenv("HOME"));
-	if (mkpath(buf, 0700) < 0) {
-	  fprintf(stderr, "Can not create *var-path*: %s\n", buf);
-	  exit(-1);
-	}
-	chdir(buf);
-	*strrchr(buf,'/') = 0;
-	printf("var:%s\n", buf);
-	twk_set_var_path(buf);
+	twinkle_init_dirs();
 
 	snprintf(cef_cache_path, sizeof(cef_cache_path),
 		 "%s/.config/twinkle/cache/cef_cache",
 		 getenv("HOME"));
-	if (mkpath(cef_cache_path, 0700) < 0) {
+	if (twinkle_mkpath(cef_cache_path, 0700) < 0) {
 	  fprintf(stderr, "can not create cache path\n");
 	  exit(-1);
 	}
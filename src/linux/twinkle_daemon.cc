@@ -0,0 +1,86 @@
+/*    
+ * Copyright (C) 2020, Twinkle Labs, LLC.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// twinkle-daemon -- The app server without a window
+//
+// Runs the control process, as the desktop shell does, but without
+// CEF or GTK, so that sync, post and blob processing go on when no
+// window is open. See twinkle-daemon.service to run it as a user
+// service. The shell and browsers attach to it at the port it writes
+// to CONTROL_PORT_FILE, see twinkle_dirs.h.
+//
+// If control already runs, in another daemon or in a shell, there is
+// nothing to do and it exits.
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "twinkle_dirs.h"
+#include "twk.h"
+
+#define MESG_HTTPD_STARTED "(httpd-started"
+#define MESG_HTTPD_FAILED "(httpd-failed"
+static void receive_message(void *ctx, const char* s)
+{
+	printf("TWK MESSAGE: %s\n", s);
+	fflush(stdout);
+	if (strstr(s, MESG_HTTPD_STARTED) == s) {
+		twinkle_write_control_port(atoi(s + sizeof(MESG_HTTPD_STARTED)));
+	}
+	else if (strstr(s, MESG_HTTPD_FAILED) == s) {
+		twinkle_write_control_port(0);
+	}
+}
+
+static void quit(int sig)
+{
+	unlink(CONTROL_PORT_FILE);
+	_exit(0);
+}
+
+int main(int argc, char* argv[]) 
+{
+	twinkle_init_dirs();
+
+	// Not a failure, so that the service is not restarted over it
+	if (twinkle_lock_control() != 0) {
+		printf("Control is already running, see %s\n",
+		       CONTROL_LOCK_FILE);
+		return 0;
+	}
+
+	signal(SIGINT, quit);
+	signal(SIGTERM, quit);
+	signal(SIGHUP, quit);
+
+	twk_set_receive_message(receive_message, NULL);
+	static const char *args[] = {
+		"twk", "launch", "control", "--port", ",6780"
+	};
+	int ret = twk_start(sizeof(args) / sizeof(args[0]), args);
+	if (ret != 0) {
+		fprintf(stderr, "twk_start() error\n");
+		exit(-1);
+	}
+
+	// The processes of twk run on their own
+	for (;;)
+		pause();
+	return 0;
+}
@@ -0,0 +1,115 @@
+/*    
+ * Copyright (C) 2020, Twinkle Labs, LLC.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "twinkle_dirs.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include "twk.h"
+
+int twinkle_mkpath(char *path, mode_t mode)
+{
+  char *p = path;
+  while (p&&*p) {
+    p = strchr(p+1, '/');
+    if (p) *p = 0;
+    if (mkdir(path, mode) == -1) {
+      if (errno != EEXIST) {
+	if (p) *p = '/';
+	return -1;
+      }
+    }
+    if (p) {
+      *p++ = '/';
+    }
+  }
+  return 0;
+}
+
+void twinkle_init_dirs()
+{
+	char buf[1024];
+
+	ssize_t n = readlink("/proc/self/exe", buf, sizeof(buf));
+	assert(n > 0);
+	if (n < 0 || (size_t)n >= sizeof(buf))
+	  exit(-1);
+	buf[n] = 0;
+	*strrchr(buf,'/')=0;
+	printf("dist:%s\n", buf);
+	twk_set_dist_path(buf);
+	
+	snprintf(buf, sizeof(buf), "%s/.config/twinkle/run", getenv("HOME"));
+	if (twinkle_mkpath(buf, 0700) < 0) {
+	  fprintf(stderr, "Can not create *var-path*: %s\n", buf);
+	  exit(-1);
+	}
+	if (chdir(buf) != 0) {
+	  fprintf(stderr, "Can not change to %s\n", buf);
+	  exit(-1);
+	}
+	*strrchr(buf,'/') = 0;
+	printf("var:%s\n", buf);
+	twk_set_var_path(buf);
+}
+
+int twinkle_lock_control()
+{
+	int fd = open(CONTROL_LOCK_FILE, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+	if (fd < 0) {
+		fprintf(stderr, "Can not open %s\n", CONTROL_LOCK_FILE);
+		return -1;
+	}
+	// Released by the system when we exit, even if killed
+	if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+		close(fd);
+		return -1;
+	}
+	return 0;
+}
+
+int twinkle_read_control_port()
+{
+	FILE *fp = fopen(CONTROL_PORT_FILE, "r");
+	if (!fp)
+		return 0;
+	int port = 0;
+	if (fscanf(fp, "%d", &port) != 1)
+		port = 0;
+	fclose(fp);
+	return port > 0 ? port : 0;
+}
+
+void twinkle_write_control_port(int port)
+{
+	if (port <= 0) {
+		unlink(CONTROL_PORT_FILE);
+		return;
+	}
+	FILE *fp = fopen(CONTROL_PORT_FILE, "w");
+	if (fp) {
+		fprintf(fp, "%d\n", port);
+		fclose(fp);
+	}
+}
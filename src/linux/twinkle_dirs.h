@@ -0,0 +1,52 @@
+/*    
+ * Copyright (C) 2020, Twinkle Labs, LLC.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// What the desktop shell and twinkle-daemon share: the directories,
+// and which of them runs the control process.
+//
+// Only one control process may run on *var-path*. Whoever runs it
+// holds CONTROL_LOCK_FILE, and writes the port of its app server to
+// CONTROL_PORT_FILE, both in *var-path*/run. The others attach to
+// that port, see findControlPort() in twinkle_app.cc.
+
+#ifndef TWINKLE_DIRS_H
+#define TWINKLE_DIRS_H
+
+#include <sys/types.h>
+
+#define CONTROL_LOCK_FILE "twinkle-control.lock"
+#define CONTROL_PORT_FILE "twinkle-control.port"
+
+// mkdir -p
+int twinkle_mkpath(char *path, mode_t mode);
+
+// Set the dist path to where the executable is, and the var path to
+// ~/.config/twinkle, and change to its run directory. Exits if they
+// can not be set up.
+void twinkle_init_dirs();
+
+// Take CONTROL_LOCK_FILE, which is held until we exit.
+// Return 0, or -1 if another process has it.
+int twinkle_lock_control();
+
+// Port of the control process which holds the lock, or 0
+int twinkle_read_control_port();
+
+// Write <port> to CONTROL_PORT_FILE, or remove it if 0
+void twinkle_write_control_port(int port);
+
+#endif
@@ -19,6 +19,14 @@
 #include "twinkle_app.h"
 
 #include <string>
+#if defined(OS_LINUX)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "twinkle_dirs.h"
+#endif
 
 #include "include/base/cef_bind.h"
 #include "include/wrapper/cef_closure_task.h"
@@ -85,6 +93,14 @@ void TwinkleApp::OnBeforeCommandLineProcessing(
 #endif
 }
 
+static std::string appURL(int port)
+{
+	std::string url = "http://127.0.0.1:";
+	url += std::to_string(port);
+	url += "/main.html";
+	return url;
+}
+
 static void loadAppAtPort(int port)
 {
 	CEF_REQUIRE_UI_THREAD();
@@ -96,9 +112,7 @@ static void loadAppAtPort(int port)
 		url = "about:blank";
 	}
 	else {
-		url = "http://127.0.0.1:";
-		url += std::to_string(port);
-		url += "/main.html";
+		url = appURL(port);
 	}
 	TwinkleHandler::GetInstance()->GetFirstBrowser()->GetMainFrame()->LoadURL(url);
 }
@@ -112,6 +126,9 @@ static void receive_message(void *ctx, const char* s)
 	printf("TWK MESSAGE: %s\n", s);
 	if (strstr(s, MESG_HTTPD_STARTED) == s) {
 		int port = atoi(s + sizeof(MESG_HTTPD_STARTED));
+#if defined(OS_LINUX)
+		twinkle_write_control_port(port);
+#endif
 		if (!active_port) {
 			active_port = port;
 		}
@@ -129,6 +146,46 @@ static void receive_message(void *ctx, const char* s)
 }
 
 
+#if defined(OS_LINUX)
+// True if an app server answers at <port>. The port file may be left
+// by a control process which was killed.
+static bool isListening(int port)
+{
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0)
+		return false;
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	bool ok = connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+	close(fd);
+	return ok;
+}
+#endif
+
+// Port of the control process of twinkle-daemon or another shell,
+// or 0 if we run our own, see src/linux/twinkle_dirs.h
+static int findControlPort()
+{
+#if defined(OS_LINUX)
+	if (twinkle_lock_control() == 0)
+		return 0;
+	// Give one which is starting the time to write its port
+	for (int i = 0; i < 50; i++) {
+		int port = twinkle_read_control_port();
+		if (port && isListening(port))
+			return port;
+		usleep(100000);
+	}
+	fprintf(stderr, "Control is running, but not its app server\n");
+	exit(-1);
+#else
+	return 0;
+#endif
+}
+
 static void startAppServer()
 {
 	twk_set_receive_message(receive_message, NULL);
@@ -172,6 +229,14 @@ void TwinkleApp::OnContextInitialized() {
  // if (url.empty())
  //   url = "about:blank";
 
+  // Attach to the app server of twinkle-daemon or another window
+  // if one runs, instead of starting our own.
+  const int control_port = findControlPort();
+  if (control_port && url.empty()) {
+    printf("Attach to control at port %d\n", control_port);
+    url = appURL(control_port);
+  }
+
   if (use_views) {
     // Create the BrowserView.
     CefRefPtr<CefBrowserView> browser_view = CefBrowserView::CreateBrowserView(
@@ -195,5 +260,6 @@ void TwinkleApp::OnContextInitialized() {
 
   }
 
-  startAppServer();
+  if (!control_port)
+    startAppServer();
 }
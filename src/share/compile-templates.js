@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2020, Twinkle Labs, LLC.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Compile web/locale/<lang>/templates.html into render functions,
+// so that the app does not parse the templates when it starts.
+//
+//   node compile-templates.js <web dir> <out dir>
+//
+// writes <out dir>/<lang>/templates/<group>.js for every locale.
+// A template goes to the group of the only viewer script referring
+// to it, or to 'common', and index.js lists the groups. See
+// cloneTemplate() in web/js/template.js, which parses templates.html
+// at runtime, as during development, when there is no index.js.
+//
+// The output is meant for a package, where it is copied over
+// web/locale. Compiled templates next to templates.html in the
+// source tree would be preferred to it, however stale.
+
+const fs = require('fs');
+const path = require('path');
+
+const VOID_TAGS = ['area', 'base', 'br', 'col', 'embed', 'hr', 'img',
+                   'input', 'link', 'meta', 'source', 'track', 'wbr'];
+const RAW_TAGS = ['pre', 'textarea'];
+
+// Start tags which close an open <p>, as in a browser
+const CLOSE_P_TAGS = ['address', 'article', 'aside', 'blockquote', 'div',
+                      'dl', 'fieldset', 'footer', 'form', 'h1', 'h2', 'h3',
+                      'h4', 'h5', 'h6', 'header', 'hr', 'menu', 'nav', 'ol',
+                      'p', 'pre', 'section', 'table', 'ul'];
+
+const ENTITIES = { lt: '<', gt: '>', amp: '&', quot: '"', apos: "'", nbsp: ' ' };
+
+function decodeEntities(s) {
+    return s.replace(/&(#x[0-9a-fA-F]+|#[0-9]+|[a-zA-Z]+);/g, function(m, e) {
+        if (e[0] == '#') {
+            return String.fromCodePoint(e[1] == 'x' ? parseInt(e.substring(2), 16)
+                                        : parseInt(e.substring(1), 10));
+        }
+        return ENTITIES[e] !== undefined ? ENTITIES[e] : m;
+    });
+}
+
+// Parse the html of a templates file into
+// { tag, attrs: [[name, value]...], children } and text strings.
+function parse(html, file) {
+    var root = { tag: '#root', attrs: [], children: [] };
+    var stack = [root];
+    var re = /<!--[\s\S]*?-->|<\/([a-zA-Z0-9-]+)\s*>|<([a-zA-Z0-9-]+)((?:\s+[^\s=>\/]+(?:\s*=\s*(?:"[^"]*"|'[^']*'|[^\s>]+))?)*)\s*(\/?)>/g;
+    var attrRe = /([^\s=>\/]+)(?:\s*=\s*(?:"([^"]*)"|'([^']*)'|([^\s>]+)))?/g;
+    var pos = 0;
+    var m;
+
+    function top() {
+        return stack[stack.length - 1];
+    }
+
+    // Close the innermost open <tag> if there is one
+    // before any of <bounds>
+    function closeOpen(tag, bounds) {
+        for (var i = stack.length - 1; i > 0; i--) {
+            if (stack[i].tag == tag) {
+                stack.length = i;
+                return;
+            }
+            if (bounds.indexOf(stack[i].tag) >= 0)
+                return;
+        }
+    }
+
+    function addText(s) {
+        if (s.length > 0)
+            top().children.push(decodeEntities(s));
+    }
+
+    while ((m = re.exec(html)) != null) {
+        addText(html.substring(pos, m.index));
+        pos = re.lastIndex;
+        if (m[1]) {
+            // Like a browser, ignore end tags of void or unopened
+            // elements, and close those left open inside.
+            var tag = m[1].toLowerCase();
+            var i = stack.length - 1;
+            while (i > 0 && stack[i].tag != tag)
+                i--;
+            if (top().tag != tag)
+                console.warn(file + ': unexpected </' + tag + '> in <'
+                             + top().tag + '> at ' + m.index);
+            if (i > 0)
+                stack.length = i;
+        } else if (m[2]) {
+            var el = { tag: m[2].toLowerCase(), attrs: [], children: [] };
+            if (CLOSE_P_TAGS.indexOf(el.tag) >= 0)
+                closeOpen('p', ['template', 'button']);
+            else if (el.tag == 'li')
+                closeOpen('li', ['template', 'ul', 'ol']);
+            else if (el.tag == 'option')
+                closeOpen('option', ['template', 'select']);
+            var a;
+            attrRe.lastIndex = 0;
+            while ((a = attrRe.exec(m[3])) != null) {
+                var v = a[2] !== undefined ? a[2] : a[3] !== undefined ? a[3] : a[4];
+                el.attrs.push([a[1].toLowerCase(), v === undefined ? '' : decodeEntities(v)]);
+            }
+            top().children.push(el);
+            if (VOID_TAGS.indexOf(el.tag) < 0 && !m[4])
+                stack.push(el);
+        }
+    }
+    addText(html.substring(pos));
+    if (stack.length != 1)
+        throw new Error(file + ': <' + top().tag + '> is not closed');
+    return root;
+}
+
+// Whitespace is kept, as innerHTML would, but runs of it are collapsed
+// outside of <pre> and <textarea>, where the first newline is dropped.
+function normalize(el, raw) {
+    var u = [];
+    el.children.forEach(function(x, i) {
+        if (typeof x != 'string') {
+            normalize(x, raw || RAW_TAGS.indexOf(x.tag) >= 0);
+            u.push(x);
+        } else if (raw) {
+            if (i == 0 && RAW_TAGS.indexOf(el.tag) >= 0)
+                x = x.replace(/^\r?\n/, '');
+            if (x.length > 0)
+                u.push(x);
+        } else {
+            u.push(x.replace(/\s+/g, ' '));
+        }
+    });
+    el.children = u;
+}
+
+// Same pattern as Expand() in web/js/template.js
+const VAR_RE = /{{\s([\w\.]+)\s}}/g;
+
+// JS expression for string <s>, with {{ x.y }} looked up in data d,
+// or left as it is if <literal>
+function compileString(s, literal) {
+    if (literal)
+        return JSON.stringify(s);
+    var parts = [];
+    var pos = 0;
+    var m;
+    VAR_RE.lastIndex = 0;
+    while ((m = VAR_RE.exec(s)) != null) {
+        if (m.index > pos)
+            parts.push(JSON.stringify(s.substring(pos, m.index)));
+        parts.push('x(d,' + JSON.stringify(m[1]) + ',' + JSON.stringify(m[0]) + ')');
+        pos = VAR_RE.lastIndex;
+    }
+    if (pos < s.length || parts.length == 0)
+        parts.push(JSON.stringify(s.substring(pos)));
+    return parts.join('+');
+}
+
+function compileNode(x, literal) {
+    if (typeof x == 'string')
+        return compileString(x, literal);
+    var attrs = x.attrs.map(function(a) {
+        return JSON.stringify(a[0]) + ':' + compileString(a[1], literal);
+    });
+    var children = x.children.map(function(c) { return compileNode(c, literal); });
+    return 'h(' + JSON.stringify(x.tag)
+        + (attrs.length > 0 || children.length > 0 ? ',{' + attrs.join(',') + '}' : '')
+        + (children.length > 0 ? ',[' + children.join(',') + ']' : '')
+        + ')';
+}
+
+function hasRepeat(x) {
+    if (typeof x == 'string')
+        return false;
+    return x.attrs.some(function(a) { return a[0].indexOf('data-repeat') === 0; })
+        || x.children.some(hasRepeat);
+}
+
+// { id: source of the render function }
+function compileTemplates(html, file) {
+    var root = parse(html, file);
+    var result = {};
+    root.children.forEach(function(t) {
+        if (typeof t == 'string' || t.tag != 'template')
+            return;
+        var id = (t.attrs.find(function(a) { return a[0] == 'id'; }) || [])[1];
+        var el = t.children.find(function(c) { return typeof c != 'string'; });
+        if (!id || !el) {
+            console.warn(file + ': skipped template without id or element');
+            return;
+        }
+        normalize(el, RAW_TAGS.indexOf(el.tag) >= 0);
+        // Repeats are rare enough to be left to Expand()
+        result[id] = hasRepeat(el)
+            ? 'function(d){var e=' + compileNode(el, true) + ';if(d)Expand(e,d);return e;}'
+            : 'function(d){return ' + compileNode(el) + ';}';
+    });
+    return result;
+}
+
+// { template id: group }, by the viewer scripts referring to them.
+// Scripts outside of js/viewers are all in 'common'.
+function findGroups(webDir) {
+    var refs = {};
+    function scan(dir, group) {
+        fs.readdirSync(dir).forEach(function(f) {
+            if (!f.endsWith('.js'))
+                return;
+            var src = fs.readFileSync(path.join(dir, f), 'utf8');
+            var g = group || f.replace(/\.js$/, '');
+            (src.match(/['"]tpl-[\w-]+['"]/g) || []).forEach(function(s) {
+                var id = s.substring(1, s.length - 1);
+                (refs[id] = refs[id] || {})[g] = true;
+            });
+        });
+    }
+    scan(path.join(webDir, 'js'), 'common');
+    scan(path.join(webDir, 'js', 'viewers'));
+    var groups = {};
+    Object.keys(refs).forEach(function(id) {
+        var u = Object.keys(refs[id]);
+        groups[id] = u.length == 1 ? u[0] : 'common';
+    });
+    return groups;
+}
+
+function compileLocale(webDir, outDir, lang, groups) {
+    var file = path.join(webDir, 'locale', lang, 'templates.html');
+    var templates = compileTemplates(fs.readFileSync(file, 'utf8'), file);
+    var files = {};
+    Object.keys(templates).forEach(function(id) {
+        var g = groups[id] || 'common';
+        (files[g] = files[g] || []).push(JSON.stringify(id) + ':' + templates[id]);
+    });
+    var out = path.join(outDir, lang, 'templates');
+    fs.mkdirSync(out, { recursive: true });
+    Object.keys(files).forEach(function(g) {
+        fs.writeFileSync(path.join(out, g + '.js'),
+                         '// Generated from ../templates.html by src/share/compile-templates.js\n'
+                         + 'registerTemplates(' + JSON.stringify(lang) + ',(function(h,x){return {\n'
+                         + files[g].join(',\n')
+                         + '\n};})(templateElement,templateValue));\n');
+    });
+    fs.writeFileSync(path.join(out, 'index.js'),
+                     '// Generated by src/share/compile-templates.js\n'
+                     + 'registerTemplateGroups(' + JSON.stringify(lang) + ','
+                     + JSON.stringify(Object.keys(files).sort()) + ');\n');
+    console.log(lang + ': ' + Object.keys(templates).length + ' templates in '
+                + Object.keys(files).length + ' groups');
+}
+
+if (process.argv.length != 4) {
+    console.error('usage: node compile-templates.js <web dir> <out dir>');
+    process.exit(1);
+}
+var webDir = process.argv[2];
+var outDir = process.argv[3];
+var groups = findGroups(webDir);
+fs.readdirSync(path.join(webDir, 'locale')).forEach(function(lang) {
+    if (fs.existsSync(path.join(webDir, 'locale', lang, 'templates.html')))
+        compileLocale(webDir, outDir, lang, groups);
+});
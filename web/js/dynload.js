@@ -88,5 +88,145 @@ window.dynload = (function() {
         }), success, error);
     }
 
+    // Libraries which are not in main.html, by name
+    var libraries = {
+        chart: ['/lib/chartjs/Chart.min.js'],
+        diff: ['/lib/jsdiff.js'],
+        hammer: ['/lib/hammer/hammer.min.js'],
+        katex: ['/lib/katex/katex.min.js'],
+        qrcode: ['/lib/qrcode/qrcode.min.js'],
+        recorder: ['/lib/audio-recorder-polyfill2.js']
+    };
+
+    // Viewer manifest: what a viewer type needs before it loads,
+    // besides main.html. <script> registers the viewer, and its
+    // compiled templates are loaded along, see main.js.
+    var viewers = {
+        'calc': { script: '/js/viewers/calc.js', name: 'Calculator' },
+        'dashboard': { script: '/js/viewers/dashboard.js', libs: ['chart'] },
+        'image': { libs: ['hammer'] },
+        'ledger-account-report': { libs: ['chart'] },
+        'processes': { script: '/js/viewers/dashboard.js', libs: ['chart'] },
+        'qrcode': { libs: ['qrcode'] },
+        'space-export': { libs: ['qrcode'] },
+        'space-invite': { libs: ['qrcode'] },
+        'timeline': { libs: ['diff'] },
+        'videochat': { script: '/js/viewers/videochat.js', name: 'VideoChat' },
+        'whiteboard': { script: '/js/viewers/whiteboard.js', name: 'Whiteboard' }
+    };
+
+    var loaded = {}; // url => true, or callbacks while loading
+
+    // Load each of <urls> only once, however often asked
+    function loadOnce(urls, success, error) {
+        var n = urls.length + 1;
+        function done() {
+            if (--n == 0)
+                success();
+        }
+        urls.forEach(function(url) {
+            var x = loaded[url];
+            if (x === true)
+                return done();
+            if (x)
+                return x.push(done);
+            loaded[url] = [done];
+            loadFiles([{url:url}], function() {
+                var u = loaded[url];
+                loaded[url] = true;
+                u.forEach(function(f) { f(); });
+            }, function(err) {
+                delete loaded[url];
+                if (error)
+                    error(err);
+            });
+        });
+        done();
+    }
+
+    function librariesOf(names) {
+        var u = [];
+        names.forEach(function(x) {
+            u = u.concat(libraries[x]);
+        });
+        return u;
+    }
+
+    // Name of the template group of a viewer script,
+    // see src/share/compile-templates.js
+    function templateGroupOf(script) {
+        return script.replace(/^.*\//, '').replace(/\.js$/, '');
+    }
+
+    function urlsOfViewer(type) {
+        var v = viewers[type];
+        if (!v)
+            return [];
+        var u = librariesOf(v.libs || []);
+        if (v.script) {
+            var g = templateGroupOf(v.script);
+            var langs = templateLocale == 'default'
+                ? ['default'] : ['default', templateLocale];
+            langs.forEach(function(lang) {
+                if ((templateGroups[lang] || []).indexOf(g) >= 0)
+                    u.push('/locale/' + lang + '/templates/' + g + '.js');
+            });
+            u.push(v.script);
+        }
+        return u;
+    }
+
+    dynload.viewers = viewers;
+
+    // Load libraries <names>, then call <success>
+    dynload.require = function(names, success, error) {
+        loadOnce(librariesOf(names), success, error);
+    };
+
+    dynload.isViewerReady = function(type) {
+        return urlsOfViewer(type).every(function(url) {
+            return loaded[url] === true;
+        });
+    };
+
+    // Load what viewer <type> needs, then call <success>
+    dynload.viewer = function(type, success, error) {
+        var now = performance.now();
+        loadOnce(urlsOfViewer(type), function() {
+            console.log('dynload:', type, performance.now()-now);
+            success();
+        }, error);
+    };
+
+    // Whether template group <g> is loaded with its viewer
+    dynload.isLazyTemplateGroup = function(g) {
+        return Object.keys(viewers).some(function(type) {
+            var v = viewers[type];
+            return v.script && templateGroupOf(v.script) == g;
+        });
+    };
+
+    // Load everything in the manifest, one file at a time
+    // whenever the browser is idle
+    dynload.prefetch = function() {
+        var idle = window.requestIdleCallback || function(f) {
+            setTimeout(f, 200);
+        };
+        var u = [];
+        Object.keys(libraries).forEach(function(x) {
+            u = u.concat(libraries[x]);
+        });
+        Object.keys(viewers).forEach(function(type) {
+            u = u.concat(urlsOfViewer(type));
+        });
+        (function next() {
+            var url = u.shift();
+            if (url)
+                idle(function() {
+                    loadOnce([url], next, next);
+                });
+        })();
+    };
+
     return dynload;
 })();
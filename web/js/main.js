@@ -23,6 +23,13 @@ function websocketURLFromPath(path) {
     }
 }
 
+// The workspace is saved at most every SNAPSHOT_DELAY ms, and not
+// at all if larger than SNAPSHOT_MAX_SIZE. Images are kept if inline
+// and smaller than SNAPSHOT_MAX_IMAGE.
+const SNAPSHOT_DELAY = 30000;
+const SNAPSHOT_MAX_SIZE = 512 * 1024;
+const SNAPSHOT_MAX_IMAGE = 16 * 1024;
+
 window.app = {
     version: '20200205',
     config: null,
@@ -32,6 +39,8 @@ window.app = {
     logMessages: [],
     logMessageId: 0,
     echoTimer: null,
+    snapshotTimer: null,
+    lastSnapshot: null,
     sounds: {
         error: new Audio("/snd/error.mp3")
     },
@@ -88,42 +97,69 @@ window.app = {
     },
     removeKey:function(){
         localStorage.removeItem('SPL-Key');
+        app.clearSnapshot();
     },
     init: function(config) {
         app.config = config;
         var theme = '/theme/' + (localStorage.getItem('Theme')||'default') + '/style.css';
         var resources = [
-            '/theme/' + (localStorage.getItem('Theme')||'default') + '/style.css',
-            {
-                url:'/locale/default/templates.html',
-                got:function(x){
-                    document.getElementById('tpl-container-default').innerHTML=x;
-                }
-            }
+            '/theme/' + (localStorage.getItem('Theme')||'default') + '/style.css'
         ];
+        var pending = 2;
         var lang = localStorage.getItem('Language');
         if (!lang || lang == 'default')
             lang = navigator.language;
         if (locale.isAvailable(lang)) {
             moment.locale(lang);
             resources.push('/locale/'+lang+'/strings.js');
-            resources.push({
-                url: '/locale/'+lang+'/templates.html',
-                got: function(x){
-                    document.getElementById('tpl-container-locale').innerHTML=x;
-                }
-            });
+            templateLocale = lang;
+            pending++;
         }
         
         console.log('load1:',config.loadDuration);
         var now = performance.now();
+        function didLoad(what) {
+            console.log('load2:', what, performance.now()-now);
+            if (--pending == 0)
+                app.didLoadResources();
+        }
         dynload(resources,function(){
-            console.log('load2:',performance.now()-now);
-            app.didLoadResources();            
+            didLoad('resources');
+        });
+        app.loadTemplates('default', 'tpl-container-default', didLoad);
+        if (templateLocale != 'default')
+            app.loadTemplates(lang, 'tpl-container-locale', didLoad);
+    },
+    // Load the templates of <lang> compiled by
+    // src/share/compile-templates.js, or else parse templates.html
+    // into #<container>, as during development. See cloneTemplate().
+    loadTemplates: function(lang, container, success) {
+        var base = '/locale/' + lang + '/templates';
+        dynload([base + '/index.js'], function() {
+            // Those of viewers loaded on first use come along
+            var groups = templateGroups[lang].filter(function(g) {
+                return !dynload.isLazyTemplateGroup(g);
+            });
+            dynload(groups.map(function(g) {
+                return base + '/' + g + '.js';
+            }), function() {
+                success('templates ' + lang);
+            }, app.err);
+        }, function() {
+            dynload([{
+                url: base + '.html',
+                got: function(x) {
+                    document.getElementById(container).innerHTML = x;
+                }
+            }], function() {
+                success('templates.html ' + lang);
+            }, app.err);
         });
     },
     didLoadResources: function(){
         app.initWorkspace();    
+        // What is not in main.html, see dynload.js
+        dynload.prefetch();
         var params = getHashParameters();
         app.osType = params.os ||  localStorage.getItem('osType') || 'generic';
         localStorage.setItem('osType', app.osType);
@@ -138,6 +174,7 @@ window.app = {
                 console.log("did requestAccess:",x);
                 if (!x.accessToken) { // The space is not exist
                     app.echo('Can not access');
+                    app.didShowWorkspace();
                 } else {
                     document.cookie = 'access-token='+x.accessToken;
                     app.echo('Access OK');
@@ -164,6 +201,7 @@ window.app = {
                         type: 'welcome'
                     });
                 }
+                app.didShowWorkspace();
             }, function(e) {
                 app.err(e.error);
             });
@@ -273,6 +311,15 @@ window.app = {
                 }
             });
 
+            // Blobs pulled while the space was closed are processed
+            // after it opens, see Blob processing in proc/space.l
+            mux.on('on-process-progress', app, function(done, total) {
+                if (done < total)
+                    app.echo('Processing ' + done + '/' + total);
+                else
+                    app.echo('Space OK');
+            });
+
             mux.on('console', app, function(type, msg) {
                 app.addLog(type, msg);
             });
@@ -316,6 +363,8 @@ window.app = {
                     uuid: mux.currentUser.uuid
                 });
             }
+            app.didShowWorkspace();
+            app.watchSnapshot();
 
             if (localStorage.getItem('deviceToken')) {
                 mux.request('space-do', [
@@ -327,6 +376,82 @@ window.app = {
             }
         });
     },
+    didShowWorkspace: function() {
+        if (app.config.didShowWorkspace)
+            app.config.didShowWorkspace();
+    },
+
+    // A snapshot of the workspace is a standalone page, without
+    // scripts, which main.html shows at launch until the app is ready.
+    buildSnapshot: function() {
+        var wrapper = document.querySelector('.wrapper').cloneNode(true);
+        wrapper.querySelectorAll('script,video,audio,canvas,iframe,object,embed')
+            .forEach(function(el) {
+                el.parentNode.removeChild(el);
+            });
+        wrapper.querySelectorAll('img').forEach(function(el) {
+            var src = el.getAttribute('src') || '';
+            if (!src.startsWith('data:') || src.length > SNAPSHOT_MAX_IMAGE)
+                el.removeAttribute('src');
+        });
+        // Our own styles, not those of libraries with their fonts
+        var css = [];
+        Array.prototype.forEach.call(document.styleSheets, function(sheet) {
+            if (sheet.href && !/\/(css|theme)\//.test(sheet.href))
+                return;
+            Array.prototype.forEach.call(sheet.cssRules, function(r) {
+                if (r.type != CSSRule.FONT_FACE_RULE)
+                    css.push(r.cssText);
+            });
+        });
+        css.push('body { pointer-events: none; }');
+        return '<!DOCTYPE HTML><html><head><meta charset="utf-8">'
+            + '<meta http-equiv="Content-Security-Policy" content="script-src \'none\'">'
+            + '<title>Twinkle Notes</title>'
+            + '<style>' + css.join('\n') + '</style></head><body>'
+            + wrapper.outerHTML
+            + '</body></html>';
+    },
+
+    saveSnapshot: function() {
+        var html = app.buildSnapshot();
+        if (html == app.lastSnapshot || html.length > SNAPSHOT_MAX_SIZE)
+            return;
+        app.lastSnapshot = html;
+        try {
+            localStorage.setItem('shellSnapshot', html);
+        } catch (e) {
+            console.log('snapshot:', e);
+        }
+    },
+
+    // Notes are not left around once the key is gone
+    clearSnapshot: function() {
+        localStorage.removeItem('shellSnapshot');
+        app.lastSnapshot = null;
+    },
+
+    watchSnapshot: function() {
+        function schedule() {
+            if (app.snapshotTimer || !app.getSavedKey())
+                return;
+            app.snapshotTimer = setTimeout(function() {
+                app.snapshotTimer = null;
+                app.saveSnapshot();
+            }, SNAPSHOT_DELAY);
+        }
+        new MutationObserver(schedule).observe(document.querySelector('.wrapper'), {
+            childList: true,
+            subtree: true,
+            characterData: true
+        });
+        document.addEventListener('visibilitychange', function() {
+            if (document.visibilityState == 'hidden' && app.getSavedKey())
+                app.saveSnapshot();
+        });
+        schedule();
+    },
+
     setDeviceInfo: function(token, type) {
         localStorage.setItem('deviceToken', token);
         localStorage.setItem('deviceType', type);
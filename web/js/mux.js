@@ -40,6 +40,13 @@ off(): stop receiving notifications.
 
 */
 
+// Highest frame protocol we understand. See ws/mux.l
+const MUX_PROTOCOL_VERSION = 2;
+
+// Messages larger than this (in bytes) are decoded by js/sexp-worker.js,
+// so that a big response does not block the UI thread.
+const MUX_WORKER_THRESHOLD = 64 * 1024;
+
 function MUX(ws_url) {
     var self = this;
     var reqcnt = 0;
@@ -49,11 +56,30 @@ function MUX(ws_url) {
     var reqs = {};
     var listeners = {};
     var reconnect_count = 0;
+    var debug = localStorage.getItem('muxDebug') == 'true';
+    var utf8Decoder = new TextDecoder('utf-8');
+    var utf8Encoder = new TextEncoder();
+    var inbox = [];  // received messages in order, see receive()
+    var sexpWorker = null; // false if not available
+    var workerJobs = {};
+    var workerSeq = 0;
 
     self.pid = null;
     self.clientId = null;
     self.currentUser = null;
     self.currentSpace = null;
+    self.protocolVersion = 1;
+
+    // Traffic counters, see getStats()
+    var stats = {
+        framesIn: 0,
+        messagesIn: 0,
+        bytesIn: 0,
+        bytesOut: 0,
+        workerMessages: 0,
+        workerParseTime: 0,
+        latency: {} // method => [ms, ...]
+    };
 
     // Test if current user is the owner of space
     self.isOwner = function() {
@@ -64,6 +90,7 @@ function MUX(ws_url) {
     function connect() {
         opened = false;
         ws = new WebSocket(ws_url);
+        ws.binaryType = 'arraybuffer';
         ws.addEventListener('open', onWSOpen);
         ws.addEventListener('message', onWSMessage);
         ws.addEventListener('error', onWSError);
@@ -73,7 +100,9 @@ function MUX(ws_url) {
     function send(msg)
     {
         if (opened) {
-            console.log("WS Send:"+msg);
+            if (debug)
+                console.log("WS Send:"+msg);
+            stats.bytesOut += msg.length;
             ws.send(msg);
         } else {
             mq.push(msg);
@@ -89,14 +118,142 @@ function MUX(ws_url) {
     };
 
     function onWSOpen() {
-	var s = "(hello)";
-        console.log("WS Send: " + s);
+	var s = "(hello " + MUX_PROTOCOL_VERSION + ")";
+        if (debug)
+            console.log("WS Send: " + s);
 	ws.send(s);
     }
 
+    // Split a version 2 frame into messages.
+    // Frame: <byte-length>:<sexp><byte-length>:<sexp>...
+    // Lengths are UTF-8 byte counts, so we work on bytes.
+    function splitFrame(bytes) {
+        var messages = [];
+        var pos = 0;
+        while (pos < bytes.length) {
+            var n = 0;
+            var c;
+            while ((c = bytes[pos++]) != 58) { // ':'
+                if (c < 48 || c > 57)
+                    throw new Error('bad frame');
+                n = n * 10 + (c - 48);
+            }
+            messages.push(bytes.subarray(pos, pos + n));
+            pos += n;
+        }
+        return messages;
+    }
+
     function onWSMessage(event) {
-        console.log("WS Received:" + event.data);
-        var msg = SEXP.parseMessage(event.data);
+        var data = event.data;
+        var bytes = null;
+        if (typeof data === 'string') {
+            stats.bytesIn += data.length;
+        } else {
+            bytes = new Uint8Array(data);
+            stats.bytesIn += bytes.length;
+        }
+        stats.framesIn++;
+        if (debug)
+            console.log("WS Received:", data);
+
+        // Version 1 frames are a single message starting with '('.
+        // Version 2 frames start with a record length.
+        var first = bytes ? bytes[0] : data.charCodeAt(0);
+        if (first >= 48 && first <= 57) {
+            if (!bytes)
+                bytes = utf8Encoder.encode(data);
+            splitFrame(bytes).forEach(receive);
+        } else {
+            receive(bytes || data);
+        }
+    }
+
+    function parseMessage(data) {
+        if (typeof data !== 'string')
+            data = utf8Decoder.decode(data);
+        var msg = SEXP.parseMessage(data);
+        if (!msg)
+            console.log("error: bad message", data);
+        return msg;
+    }
+
+    function getWorker() {
+        if (sexpWorker === null) {
+            try {
+                sexpWorker = new Worker('js/sexp-worker.js');
+                sexpWorker.onmessage = onWorkerMessage;
+                sexpWorker.onerror = onWorkerError;
+            } catch (e) {
+                console.log("sexp worker not available", e);
+                sexpWorker = false;
+            }
+        }
+        return sexpWorker;
+    }
+
+    // Receive a message, either a string or UTF-8 bytes.
+    // Large messages are parsed by the worker. Each message takes a
+    // slot in the inbox, so they are still handled in arrival order.
+    function receive(data) {
+        stats.messagesIn++;
+        var slot = { ready: false, msg: null };
+        inbox.push(slot);
+        if (data.length >= MUX_WORKER_THRESHOLD && getWorker()) {
+            var id = ++workerSeq;
+            // Keep the source, in case the worker fails.
+            workerJobs[id] = { slot: slot, data: data };
+            if (typeof data === 'string') {
+                sexpWorker.postMessage({ id: id, data: data });
+            } else {
+                var buf = data.slice().buffer;
+                sexpWorker.postMessage({ id: id, data: buf }, [buf]);
+            }
+            stats.workerMessages++;
+        } else {
+            slot.msg = parseMessage(data);
+            slot.ready = true;
+            drainInbox();
+        }
+    }
+
+    function drainInbox() {
+        while (inbox.length > 0 && inbox[0].ready) {
+            var slot = inbox.shift();
+            if (slot.msg)
+                handleMessage(slot.msg);
+        }
+    }
+
+    function onWorkerMessage(e) {
+        var job = workerJobs[e.data.id];
+        if (!job)
+            return;
+        delete workerJobs[e.data.id];
+        stats.workerParseTime += e.data.parseTime;
+        job.slot.msg = e.data.msg;
+        job.slot.ready = true;
+        if (!e.data.msg)
+            console.log("error: bad message", job.data);
+        drainInbox();
+    }
+
+    // Worker failed to load or crashed. Parse pending jobs here
+    // and stop using the worker.
+    function onWorkerError(e) {
+        console.log("sexp worker error", e);
+        sexpWorker.terminate();
+        sexpWorker = false;
+        Object.keys(workerJobs).forEach(function(id) {
+            var job = workerJobs[id];
+            job.slot.msg = parseMessage(job.data);
+            job.slot.ready = true;
+        });
+        workerJobs = {};
+        drainInbox();
+    }
+
+    function handleMessage(msg) {
         if (msg.method == 'on-notify') {
 	    /* (on-notify <event> <args>)
 	     */
@@ -107,6 +264,11 @@ function MUX(ws_url) {
 	    var req_id = msg.args[0];
 	    var r = reqs[req_id];
 	    if (r) {
+                var ms = performance.now() - r.startTime;
+                var a = stats.latency[r.method] || (stats.latency[r.method] = []);
+                if (a.length >= 200)
+                    a.shift();
+                a.push(ms);
 		var res = msg.args[1];
 		if (Array.isArray(res) && res.length > 0 && res[0] == 'error') {
 		    var e = {
@@ -126,6 +288,7 @@ function MUX(ws_url) {
             self.clientId = msg.args[0];
             self.pid = msg.args[1];
             var x = msg.args[2];
+            self.protocolVersion = msg.args[3] || 1;
 			
 			// Allow dispatch handler to send messages right away
 			// It's critical, otherwise the websocket seems to be closed
@@ -266,10 +429,14 @@ function MUX(ws_url) {
     this.sendRequestString = function(reqString, callback) {
     	var reqId = 'req-'+(++reqcnt);
     	var reqTime = (new Date()).getTime()/1000;
+        // For latency stats: "space list-notes" => "space:list-notes"
+        var method = reqString.split(' ', 2).join(':').replace(/"/g, '');
     	var reqString = "(request \"" + reqId + "\" " + reqTime + " " + reqString + ")";
     	send(reqString);
     	reqs[reqId] = {
     	    reqTime: reqTime,
+            startTime: performance.now(),
+            method: method,
     	    callback: callback
     	};
         // TODO remove timed out requests
@@ -283,6 +450,77 @@ function MUX(ws_url) {
         }
     };
     
+    // Traffic and request latency since connected.
+    // Latencies are summarized as p50/p99 in milliseconds.
+    this.getStats = function() {
+        var latency = {};
+        Object.keys(stats.latency).forEach(function(k) {
+            var a = stats.latency[k].slice().sort(function(x, y) { return x - y; });
+            latency[k] = {
+                count: a.length,
+                p50: a[Math.floor(a.length * 0.5)],
+                p99: a[Math.min(a.length - 1, Math.floor(a.length * 0.99))]
+            };
+        });
+        return {
+            protocolVersion: self.protocolVersion,
+            framesIn: stats.framesIn,
+            messagesIn: stats.messagesIn,
+            bytesIn: stats.bytesIn,
+            bytesOut: stats.bytesOut,
+            workerMessages: stats.workerMessages,
+            workerParseTime: stats.workerParseTime,
+            latency: latency
+        };
+    };
+
+    // Run each request <rounds> times one after another, and report
+    // bytes received and latency per request. For example
+    //
+    //   app.mux.benchmark([['space', ['list-notes', hash]],
+    //                      ['space', ['search-notes', 'a*', 0, 100]]], 20,
+    //                     console.log);
+    this.benchmark = function(requests, rounds, done) {
+        var results = [];
+        var i = 0;
+        var k = 0;
+        var times = [];
+        var bytes0 = stats.bytesIn;
+        var frames0 = stats.framesIn;
+        function next() {
+            if (k >= rounds) {
+                times.sort(function(x, y) { return x - y; });
+                results.push({
+                    request: requests[i][0] + ' ' + requests[i][1][0],
+                    rounds: rounds,
+                    bytesPerRound: (stats.bytesIn - bytes0) / rounds,
+                    framesPerRound: (stats.framesIn - frames0) / rounds,
+                    p50: times[Math.floor(rounds * 0.5)],
+                    p99: times[Math.min(rounds - 1, Math.floor(rounds * 0.99))]
+                });
+                i++;
+                k = 0;
+                times = [];
+                bytes0 = stats.bytesIn;
+                frames0 = stats.framesIn;
+            }
+            if (i >= requests.length) {
+                done({
+                    protocolVersion: self.protocolVersion,
+                    results: results
+                });
+                return;
+            }
+            var t = performance.now();
+            self.request(requests[i][0], requests[i][1], function() {
+                times.push(performance.now() - t);
+                k++;
+                next();
+            });
+        }
+        next();
+    };
+
     // User info caches
     // key: uuid
     // value: a dictionary
@@ -15,6 +15,73 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+/*
+ * A small LRU cache. Map keeps insertion order, so the first key
+ * is the least recently used one.
+ */
+function NoteCache(limit)
+{
+    var map = new Map();
+
+    this.get = function(key) {
+        var x = map.get(key);
+        if (x !== undefined) {
+            map.delete(key);
+            map.set(key, x);
+        }
+        return x;
+    };
+
+    this.set = function(key, value) {
+        map.delete(key);
+        map.set(key, value);
+        if (map.size > limit)
+            map.delete(map.keys().next().value);
+    };
+}
+
+// Tokens by revhash. A revision never changes.
+var noteTokenCache = new NoteCache(2000);
+
+// Typeset KaTeX html by source
+var noteMathCache = new NoteCache(1000);
+
+// Parse note <text> of revision <revhash>, reusing earlier results.
+// The returned tokens are shared, don't modify them.
+function parseNoteCached(revhash, text)
+{
+    if (!revhash)
+        return parseNote(text);
+    var tokens = noteTokenCache.get(revhash);
+    if (!tokens) {
+        tokens = parseNote(text);
+        noteTokenCache.set(revhash, tokens);
+    }
+    return tokens;
+}
+
+function renderMath(text, el, displayMode)
+{
+    var key = (displayMode ? 'D' : 'I') + text;
+    var html = noteMathCache.get(key);
+    if (html === undefined) {
+        if (typeof katex == 'undefined') {
+            // Loaded on first use, see dynload.js
+            el.textContent = text;
+            dynload.require(['katex'], function() {
+                renderMath(text, el, displayMode);
+            });
+            return;
+        }
+        html = katex.renderToString(text, {
+            displayMode: displayMode,
+            throwOnError: false
+        });
+        noteMathCache.set(key, html);
+    }
+    el.innerHTML = html;
+}
+
 function parseNote(text) {
     const PLAIN = 0;
     const MATH = 1;
@@ -409,7 +476,7 @@ function didClickImageInNote(event)
         event.stopPropagation();
         viewer.space.openViewer({
             type: 'image',
-            url: el.getAttribute('src')
+            url: el.dataset.original || el.getAttribute('src')
         }, viewer);
     }
 }
@@ -437,18 +504,13 @@ function renderNote(tokens, c, noteInstance)
             break;
         case 'math':
             var b = document.createElement('span');
-            katex.render(tok.text.substring(1,tok.text.length-1), b, {
-                throwOnError: false
-            });
+            renderMath(tok.text.substring(1,tok.text.length-1), b, false);
             container.appendChild(b);
             break;
         case 'math-block':
             var b = document.createElement('div');
             b.className = 'note-math-block';
-            katex.render(tok.text.substring(2,tok.text.length-2), b, {
-                displayMode: true,
-                throwOnError: false
-            });
+            renderMath(tok.text.substring(2,tok.text.length-2), b, true);
             container.appendChild(b);
             break;
         case 'heading':
@@ -539,7 +601,8 @@ function renderNote(tokens, c, noteInstance)
             switch (type) {
             case 'image':
                 el = document.createElement('img');
-                el.setAttribute('src', refParts[1]);
+                el.dataset.original = refParts[1];
+                setThumbnail(el, refParts[1], 640);
                 el.onclick = didClickImageInNote;
                 break;
             case 'avatar':
@@ -562,8 +625,8 @@ function renderNote(tokens, c, noteInstance)
 		// [open:<viewer-type>:param1=value1,param2=value2,...]
                 if (noteInstance && refParts.length > 1) {
                     var vtype = refParts[1];
-                    if (ViewerTypes[vtype]) {
-			var vconf = ViewerTypes[vtype];
+                    if (ViewerTypes[vtype] || dynload.viewers[vtype]) {
+			var vconf = ViewerTypes[vtype] || dynload.viewers[vtype];
                         var params = { type: vtype};
                         if (refParts.length > 2) {
                             refParts[2].split(',').forEach(function(x) {
@@ -0,0 +1,45 @@
+/*    
+ * Copyright (C) 2020, Twinkle Labs, LLC.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Decode large mux messages off the main thread. See mux.js.
+ *
+ * Request:  {id, data} where data is a string or an ArrayBuffer of UTF-8
+ * Response: {id, msg, parseTime}, msg is null if the message is bad.
+ */
+importScripts('sexp.js');
+
+var utf8Decoder = new TextDecoder('utf-8');
+
+onmessage = function(e) {
+    var t = performance.now();
+    var data = e.data.data;
+    var msg = null;
+    try {
+        if (typeof data !== 'string')
+            data = utf8Decoder.decode(new Uint8Array(data));
+        msg = SEXP.parseMessage(data);
+    } catch (err) {
+        msg = null;
+    }
+    postMessage({
+        id: e.data.id,
+        msg: msg,
+        parseTime: performance.now() - t
+    });
+};
@@ -171,9 +171,143 @@ function SEXP_Parser(s, pos)
     };
 }
 
+/*
+ * Index based parser, used for all messages.
+ *
+ * SEXP_Parser above reads one character at a time through closures,
+ * which is slow for large responses. This one scans with charCodeAt()
+ * and slices whole runs of text, and keeps open lists on a stack
+ * instead of recursing. Results are the same as SEXP_Parser.
+ */
+function SEXP_parseFast(s, offset)
+{
+    var pos = offset || 0;
+    var n = s.length;
+    var stack = [];
+    var cur = null;
+    var begin = -1;
+    var result = null;
+
+    function isDelimiter(c) {
+        return c === 32 || c === 9 || c === 10 || c === 13 || c === 40 || c === 41;
+    }
+
+    function checkDict(l) {
+        if (l.length > 0) {
+            var i = 0;
+            var dict = {};
+            for (; i < l.length; i++) {
+                var x = l[i];
+                if (!Array.isArray(x) || x.length != 3 || x[1] != '.')
+                    break;
+                dict[x[0]] = x[2];
+            }
+            if (i == l.length) {
+                return dict;
+            }
+        }
+        return l;
+    }
+
+    function readString() {
+        var str = '';
+        var start = ++pos;
+        while (true) {
+            if (pos >= n)
+                throw new Error('bad string');
+            var c = s.charCodeAt(pos);
+            if (c === 34) { // "
+                str += s.substring(start, pos);
+                pos++;
+                return str;
+            } else if (c === 92) { // backslash
+                str += s.substring(start, pos);
+                var e = s.charAt(pos + 1);
+                if (e == 't') {
+                    str += "\t";
+                } else if (e == 'n') {
+                    str += "\n";
+                } else if (e == 'r') {
+                    str += "\r";
+                } else if (e == "\"") {
+                    str += "\"";
+                } else if (e == "\\") {
+                    str += "\\";
+                } else {
+                    throw new Error('bad string');
+                }
+                pos += 2;
+                start = pos;
+            } else {
+                pos++;
+            }
+        }
+    }
+
+    function readAtom() {
+        var start = pos++;
+        while (pos < n && !isDelimiter(s.charCodeAt(pos)))
+            pos++;
+        var str = s.substring(start, pos);
+        if (str === 'undefined') {
+            return undefined;
+        } else if (str === 'true') {
+            return true;
+        } else if (str === 'false') {
+            return false;
+        }
+        var x = Number.parseFloat(str);
+        return Number.isNaN(x) ? str : x;
+    }
+
+    while (true) {
+        var c = s.charCodeAt(pos);
+        while (c === 32 || c === 9 || c === 10 || c === 13)
+            c = s.charCodeAt(++pos);
+        if (pos >= n) {
+            if (cur)
+                throw new Error('bad list');
+            break;
+        }
+        if (begin < 0)
+            begin = pos;
+
+        var v;
+        if (c === 40) { // (
+            stack.push(cur);
+            cur = [];
+            pos++;
+            continue;
+        } else if (c === 41 && cur) { // )
+            pos++;
+            v = checkDict(cur);
+            cur = stack.pop();
+        } else if (c === 34) {
+            v = readString();
+        } else {
+            v = readAtom();
+        }
+
+        if (cur) {
+            cur.push(v);
+        } else {
+            result = v;
+            break;
+        }
+    }
+    return {
+        data: result,
+        begin: begin,
+        end: pos
+    };
+}
 
 var SEXP = SEXP || {
     parse: function(s, offset) {
+        return SEXP_parseFast(s, offset);
+    },
+    // The original character based parser. Kept for benchmark().
+    parseSlow: function(s, offset) {
         if (!offset)
             offset = 0;
         var parser = new SEXP_Parser(s, offset);
@@ -196,6 +330,24 @@ var SEXP = SEXP || {
     },
     stringify: function(t) {
         
+    },
+    // Compare parse time of both parsers on message <s>.
+    // Returns milliseconds per MB of input.
+    benchmark: function(s, rounds) {
+        rounds = rounds || 10;
+        var mb = s.length * rounds / (1024 * 1024);
+        function run(parse) {
+            var t = performance.now();
+            for (var i = 0; i < rounds; i++)
+                parse(s, 0);
+            return (performance.now() - t) / mb;
+        }
+        return {
+            size: s.length,
+            rounds: rounds,
+            slowMsPerMB: run(SEXP.parseSlow),
+            fastMsPerMB: run(SEXP.parse)
+        };
     }
 };
 
@@ -119,12 +119,75 @@
 
 
 
-// TODO Need to have a cache on tpl.content
+// Render functions compiled from locale/<lang>/templates.html by
+// src/share/compile-templates.js, by locale and template id.
+// Without them, as during development, templates.html is parsed into
+// #tpl-container-<lang> instead. See loadTemplates() in main.js.
+var compiledTemplates = {};
+var templateGroups = {};
+var templateLocale = 'default';
+
+function registerTemplates(lang, u)
+{
+    var t = compiledTemplates[lang] || (compiledTemplates[lang] = {});
+    Object.keys(u).forEach(function(id) {
+        t[id] = u[id];
+    });
+}
+
+function registerTemplateGroups(lang, groups)
+{
+    templateGroups[lang] = groups;
+}
+
+function templateElement(tag, attrs, children)
+{
+    var el = document.createElement(tag);
+    if (attrs) {
+        Object.keys(attrs).forEach(function(k) {
+            el.setAttribute(k, attrs[k]);
+        });
+    }
+    if (children) {
+        children.forEach(function(x) {
+            el.appendChild(typeof x == 'string' ? document.createTextNode(x) : x);
+        });
+    }
+    return el;
+}
+
+// Value of {{ <address> }} in <data>, or the placeholder itself
+// without data, as Expand() does.
+function templateValue(data, address, placeholder)
+{
+    if (!data)
+        return placeholder;
+    var x = data;
+    address.split('.').forEach(function(a) {
+        if (!x.hasOwnProperty(a))
+            throw a + " is not a valid property of " + JSON.stringify(x);
+        x = x[a];
+    });
+    return String(x);
+}
+
 function cloneTemplate(id, data)
 {
-    var tpl = document.querySelector('#tpl-container-locale #'+id)
-        || document.querySelector('#tpl-container-default #'+id);
-    var el = tpl.content.cloneNode(true).firstElementChild;
+    var render = function(lang) {
+        var t = compiledTemplates[lang];
+        return t && t[id] ? t[id](data) : null;
+    };
+    var el = templateLocale != 'default' && render(templateLocale);
+    if (el)
+        return el;
+    var tpl = document.querySelector('#tpl-container-locale #'+id);
+    if (!tpl) {
+        el = render('default');
+        if (el)
+            return el;
+        tpl = document.querySelector('#tpl-container-default #'+id);
+    }
+    el = tpl.content.cloneNode(true).firstElementChild;
     if (data) {
         Expand(el, data);
     }
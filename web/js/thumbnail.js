@@ -0,0 +1,162 @@
+/*    
+ * Copyright (C) 2020, Twinkle Labs, LLC.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Thumbnails for image blobs.
+ *
+ * /blob/<hash>?w=<width> returns a smaller copy of an image blob,
+ * stored in the local dblob table (see web/index.l). The first time a
+ * size is asked for it doesn't exist yet, so we draw the original into
+ * a canvas, upload the result to /api/files/thumbnail and use it. For
+ * an original no wider than the size we upload an empty thumbnail,
+ * and ?w= returns the original from then on.
+ */
+
+// Must match space-storage-thumbnail-widths
+const THUMBNAIL_WIDTHS = [120, 240, 480, 960];
+
+var thumbnailStats = {
+    requests: 0,
+    hits: 0,
+    generated: 0,
+    bytes: 0,      // image bytes received
+    decodeTime: 0  // ms from request until the image is decoded
+};
+
+// Round display width <w> up to a thumbnail width, for the screen's
+// pixel ratio. Return 0 if the original should be used.
+function thumbnailWidth(w)
+{
+    w = w * (window.devicePixelRatio || 1);
+    for (var i = 0; i < THUMBNAIL_WIDTHS.length; i++) {
+        if (w <= THUMBNAIL_WIDTHS[i])
+            return THUMBNAIL_WIDTHS[i];
+    }
+    return 0;
+}
+
+function blobHashOfUrl(url)
+{
+    var m = /^\/blob\/([0-9a-fA-F]+)$/.exec(url);
+    return m ? m[1] : null;
+}
+
+// Display blob <url> in <img> at width <w> (CSS pixels)
+function setThumbnail(img, url, w)
+{
+    var hash = blobHashOfUrl(url);
+    var width = thumbnailWidth(w);
+    if (!hash || !width || !window.createImageBitmap) {
+        img.src = url;
+        return;
+    }
+
+    var t = performance.now();
+    var src = url + '?w=' + width;
+    thumbnailStats.requests++;
+
+    img.onload = function() {
+        img.onload = null;
+        img.onerror = null;
+        var e = performance.getEntriesByName(img.src)[0];
+        if (e)
+            thumbnailStats.bytes += e.encodedBodySize;
+        if (img.decode) {
+            img.decode().then(function() {
+                thumbnailStats.decodeTime += performance.now() - t;
+            }, function() {});
+        }
+        if (img.src.endsWith(src))
+            thumbnailStats.hits++;
+    };
+    img.onerror = function() {
+        img.onerror = null;
+        generateThumbnail(hash, width, function(blob) {
+            if (!blob) {
+                img.src = url;
+                return;
+            }
+            var objectUrl = URL.createObjectURL(blob);
+            img.onload = function() {
+                img.onload = null;
+                URL.revokeObjectURL(objectUrl);
+            };
+            img.src = objectUrl;
+        });
+    };
+    img.src = src;
+}
+
+function storeThumbnail(hash, width, type, thumb)
+{
+    var xhr = new XMLHttpRequest();
+    xhr.open("POST", "/api/files/thumbnail?" + encodeQueryParams({
+        source: hash,
+        w: width
+    }));
+    xhr.setRequestHeader('Content-Type', type);
+    xhr.send(thumb);
+}
+
+// Make thumbnail <width> of image blob <hash>, and store it.
+// <done> is called with the thumbnail, the original if it is small
+// enough, or null if it can't be decoded.
+function generateThumbnail(hash, width, done)
+{
+    var type;
+    var original;
+    fetch('/blob/' + hash, { credentials: 'same-origin' }).then(function(r) {
+        type = r.headers.get('Content-Type');
+        return r.blob();
+    }).then(function(blob) {
+        thumbnailStats.bytes += blob.size;
+        original = blob;
+        return createImageBitmap(blob);
+    }).then(function(bitmap) {
+        if (bitmap.width <= width) {
+            bitmap.close();
+            done(original);
+            // Empty, so that ?w= gives the original next time
+            storeThumbnail(hash, width, type, new Blob([]));
+            return;
+        }
+        var canvas = document.createElement('canvas');
+        canvas.width = width;
+        canvas.height = Math.round(bitmap.height * width / bitmap.width);
+        canvas.getContext('2d').drawImage(bitmap, 0, 0, canvas.width, canvas.height);
+        bitmap.close();
+        // Keep png for transparency
+        var outType = type == 'image/png' ? 'image/png' : 'image/jpeg';
+        canvas.toBlob(function(thumb) {
+            thumbnailStats.generated++;
+            done(thumb);
+            storeThumbnail(hash, width, outType, thumb);
+        }, outType, 0.85);
+    }).catch(function(e) {
+        console.log("thumbnail:", hash, e);
+        done(null);
+    });
+}
+
+function getThumbnailStats()
+{
+    var x = Object.assign({}, thumbnailStats);
+    x.avgBytes = x.requests ? x.bytes / x.requests : 0;
+    x.avgDecodeTime = x.requests ? x.decodeTime / x.requests : 0;
+    return x;
+}
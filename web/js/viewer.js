@@ -231,7 +231,7 @@ function Viewer(space, data) {
     var dispatchTable = {};
 
     if (!data.config) {
-        if (!ViewerTypes[data.type]) {
+        if (!ViewerTypes[data.type] && !dynload.viewers[data.type]) {
             throw new Error("Undefined viewer type: " + data.type);
         } else {
             self.config = ViewerTypes[data.type];
@@ -239,6 +239,17 @@ function Viewer(space, data) {
     } else {
         self.config = data.config;
     }
+
+    // The viewer is empty until what it needs beyond main.html
+    // is loaded, see dynload.js
+    if (!data.config && !dynload.isViewerReady(self.type)) {
+        self.config = { load: function() { return null; } };
+        dynload.viewer(self.type, function() {
+            self.config = ViewerTypes[self.type];
+            if (self.container)
+                self.reload();
+        }, app.err);
+    }
     
     self.on = function(op,cb) {
 	if (cb)
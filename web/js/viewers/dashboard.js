@@ -97,6 +97,76 @@ function createChartBlobActivity(ctx, type, title, labels, data)
     });
 }
 
+function createChartSyncRates(ctx)
+{
+    return new Chart(ctx, {
+        type: 'line',
+        data: {
+            labels: [],
+            datasets: [{
+                label: 'In',
+                fill: false,
+                backgroundColor: 'rgb(54, 162, 235)',
+                borderColor: 'rgb(54, 162, 235)',
+                data: []
+            }, {
+                label: 'Out',
+                fill: false,
+                backgroundColor: 'rgb(255, 99, 132)',
+                borderColor: 'rgb(255, 99, 132)',
+                data: []
+            }]
+        },
+        options: {
+            animation: false,
+            title: {
+                display: true,
+                text: 'Sync Rate'
+            },
+            tooltips: {
+                callbacks: {
+                    label: function(tooltipItem, data) {
+                        var d = data.datasets[tooltipItem.datasetIndex].data[tooltipItem.index];
+                        return humanFileSize(d) + '/s';
+                    }
+                }
+            }
+        }
+    });
+}
+
+// Lines of text describing the metrics report of one sync or post process
+function describeSyncMetrics(name, m)
+{
+    var lines = [];
+    if (!m)
+        return lines;
+    var c = m.counters || {};
+    var r = m.rate5s || {};
+    lines.push(name + ': '
+               + (c.blobsIn || 0) + ' blobs in, '
+               + (c.blobsOut || 0) + ' blobs out, '
+               + humanFileSize(r.inBytes || 0) + '/s in, '
+               + humanFileSize(r.outBytes || 0) + '/s out');
+    var rtt = m.rtt || {};
+    Object.keys(rtt).forEach(function(k) {
+        var h = rtt[k];
+        if (h.count > 0)
+            lines.push('  ' + k + ' rtt: ' + h.count + 'x, avg '
+                       + Math.round(h.sum / h.count) + 'ms, max '
+                       + Math.round(h.max) + 'ms');
+    });
+    var t = m.times || {};
+    var u = Object.keys(t).map(function(k) {
+        return k + ' ' + Math.round(t[k]) + 'ms';
+    });
+    if (u.length > 0)
+        lines.push('  time: ' + u.join(', '));
+    if (m.remain !== undefined)
+        lines.push('  remain: ' + m.remain);
+    return lines;
+}
+
 registerViewer('dashboard', {
     load: function() {
         const v = this;
@@ -168,10 +238,201 @@ registerViewer('dashboard', {
             });
         };
 
+        vc.find('#gc').onclick = function() {
+            var btn = this;
+            btn.disabled = true;
+            v.space.mux.request('space-do', [
+                'collect-garbage'
+            ], function(r) {
+                btn.disabled = false;
+                if (!r || !r.phase)
+                    return;
+                var el = vc.find('#gc-report');
+                el.textContent = r.blobs + ' blobs, '
+                    + humanFileSize(r.bytes) + ' reclaimed, '
+                    + r.tombstones + ' tombstones removed. '
+                    + humanFileSize(r.sizeBefore) + ' -> '
+                    + humanFileSize(r.sizeAfter);
+                el.classList.remove('collapse');
+            });
+        };
+
+        var ratesChart = null;
+
+        // Polled while the dashboard is shown, see unload
+        function loadSyncMetrics() {
+            v.metricsTimer = null;
+            v.space.mux.request('space-do', [
+                'get-sync-metrics'
+            ], function(x) {
+                if (!x || v.unloaded)
+                    return;
+                var lines = [];
+                lines = lines.concat(describeSyncMetrics('Host', x.host));
+                lines = lines.concat(describeSyncMetrics('Post', x.post));
+                if (x.retries && x.retries.sync > 0)
+                    lines.push('Sync retries: ' + x.retries.sync);
+                if (x.queues) {
+                    lines.push('Unsent: ' + x.queues.unsent);
+                    (x.queues.hosts || []).forEach(function(h) {
+                        lines.push('  ' + (h.name || h.uuid) + ': '
+                                   + h.unsent + ' unsent, '
+                                   + h.retrycnt + ' retries');
+                    });
+                }
+                if (lines.length == 0)
+                    lines.push('Not syncing');
+                vc.find('#sync-metrics').textContent = lines.join('\n');
+
+                var rates = (x.host && x.host.rates) || [];
+                if (!ratesChart)
+                    ratesChart = createChartSyncRates(vc.find('#chart3').getContext('2d'));
+                ratesChart.data.labels = rates.map(function(r) {
+                    return moment.unix(r.t).format('HH:mm:ss');
+                });
+                ratesChart.data.datasets[0].data = rates.map(function(r) { return r.inBytes });
+                ratesChart.data.datasets[1].data = rates.map(function(r) { return r.outBytes });
+                ratesChart.update();
+                v.metricsTimer = setTimeout(loadSyncMetrics, 2000);
+            });
+        }
+
+        vc.find('#backup').onclick = function() {
+            var btn = this;
+            v.showPrompt({
+                title: _t('Backup'),
+                message: _t('Passphrase of the archive'),
+                password: true
+            }, function(pass) {
+                v.dismissModal();
+                btn.disabled = true;
+                v.space.mux.request('space-do', [
+                    'backup', pass
+                ], function(r) {
+                    btn.disabled = false;
+                    var el = vc.find('#backup-report');
+                    if (!r || r.error)
+                        el.textContent = 'Backup failed: ' + (r ? r.error : '');
+                    else
+                        el.textContent = r.added + ' new blobs, '
+                            + r.total + ' in ' + r.path;
+                    el.classList.remove('collapse');
+                });
+            });
+        };
+
+        vc.find('#processes').onclick = function() {
+            v.space.openViewer({type: 'processes'}, v);
+        };
+
         vc.find('#range').onchange = loadRecentActivity;
         vc.find('#type').onchange = loadRecentActivity;
 
         loadRecentActivity();
+        loadSyncMetrics();
         return vc;
+    },
+
+    unload: function() {
+        this.unloaded = true;
+        if (this.metricsTimer)
+            clearTimeout(this.metricsTimer);
+    }
+});
+
+function describeProcess(p)
+{
+    var st = p.stat || {};
+    var text = '#' + p.pid + ' ' + (st.name || '') + (p.space ? ' ' + p.space : '');
+    if (!p.alive)
+        return text + ': gone';
+    if (st.uptime !== undefined)
+        text += ': up ' + st.uptime + 's, '
+            + (p.cpu || 0).toFixed(1) + '% busy, '
+            + (p.rate || 0).toFixed(1) + ' msg/s, '
+            + st.dbs + ' dbs';
+    if (st.muxes !== undefined)
+        text += ', ' + st.muxes + ' clients';
+    if (st.updates)
+        text += ', ' + st.avoided + ' of ' + st.updates + ' sync rounds coalesced';
+    if (p.latency !== undefined && p.latency !== false)
+        text += ', answers in ' + Math.round(p.latency) + 'ms';
+    if (p.waiting > 0)
+        text += ', waiting ' + Math.round(p.waiting) + 'ms';
+    return text;
+}
+
+registerViewer('processes', {
+    load: function() {
+        const v = this;
+        const vc = cloneTemplate('tpl-processes');
+        var chart = null;
+
+        function update(x) {
+            var samples = x.samples || [];
+            var last = samples[samples.length - 1];
+            var el = vc.find('#process-list');
+            el.innerHTML = '';
+            if (!last)
+                return;
+            last.processes.forEach(function(p) {
+                var para = createParagraph(describeProcess(p));
+                if (p.waiting > x.interval * 1000)
+                    para.classList.add('text-danger');
+                el.appendChild(para);
+                ((p.stat || {}).children || []).forEach(function(c) {
+                    el.appendChild(createParagraph(
+                        '- ' + c.role + ' #' + c.pid
+                            + (c.latency !== false ? ', answers in ' + Math.round(c.latency) + 'ms' : '')
+                            + (c.waiting > 0 ? ', waiting ' + Math.round(c.waiting) + 'ms' : '')));
+                });
+            });
+
+            // Busy percentage of each space process over time
+            var spaces = last.processes.filter(function(p) { return p.space; });
+            if (!chart) {
+                chart = new Chart(vc.find('#chart-cpu').getContext('2d'), {
+                    type: 'line',
+                    data: { labels: [], datasets: [] },
+                    options: {
+                        animation: false,
+                        title: { display: true, text: 'Busy %' }
+                    }
+                });
+            }
+            chart.data.labels = samples.map(function(s) {
+                return moment.unix(s.time).format('HH:mm:ss');
+            });
+            chart.data.datasets = spaces.map(function(p) {
+                return {
+                    label: '#' + p.pid,
+                    fill: false,
+                    data: samples.map(function(s) {
+                        var q = s.processes.find(function(y) { return y.pid == p.pid; });
+                        return q ? q.cpu : null;
+                    })
+                };
+            });
+            chart.update();
+        }
+
+        function load() {
+            v.telemetryTimer = null;
+            v.space.mux.request('process-telemetry', [], function(x) {
+                if (!x || v.unloaded)
+                    return;
+                update(x);
+                v.telemetryTimer = setTimeout(load, (x.interval || 5) * 1000);
+            });
+        }
+
+        load();
+        return vc;
+    },
+
+    unload: function() {
+        this.unloaded = true;
+        if (this.telemetryTimer)
+            clearTimeout(this.telemetryTimer);
     }
 });
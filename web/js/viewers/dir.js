@@ -188,18 +188,29 @@ registerViewer('dir', {
             return null;
         }
         
-        function loadFiles() {
-            elList.empty();
+        // Load all files, 100 at a time
+        var loadSeq = 0;
+        function loadFiles(cursor) {
+            if (!cursor) {
+                elList.empty();
+                loadSeq++;
+            }
+            var seq = loadSeq;
             v.space.mux.request('space', [
                 'list-files',
                 hash,
-                0,
+                cursor || "",
                 100], function(r) {
                     if (r.error) {
                         app.err(r.error);
                         return;
                     }
-                    vc.find('#count').textContent = r[0];
+                    if (seq != loadSeq)
+                        return; // reloaded meanwhile
+                    if (!cursor)
+                        vc.find('#count').textContent = r[0];
+                    if (r[2])
+                        loadFiles(r[2]);
                     r[1].forEach(function(x){
                         var el = cloneTemplate('tpl-dir-item');
                         el.data = x;
@@ -208,6 +219,12 @@ registerViewer('dir', {
                             el.find('#size').textContent = humanFileSize(x.size);
                         }
                         el.find('#icon').classList.add(getFileIcon(x));
+                        if (x.type && x.type.indexOf("image")==0) {
+                            var img = document.createElement('img');
+                            img.className = 'dir-thumbnail';
+                            setThumbnail(img, '/blob/'+x.blobhash, 40);
+                            el.find('#icon').replaceWith(img);
+                        }
                         el.find('.check-input').onclick = function(e) {
                             e.stopPropagation();
                         };
@@ -259,6 +276,9 @@ registerViewer('dir', {
                     }
                 } else {
                     var blobhash = path.substring(6);
+                    // Have the file list thumbnail ready
+                    if (/^image\//i.test(file.type))
+                        generateThumbnail(blobhash, thumbnailWidth(40), function(){});
                     v.space.mux.request('space!', [
                         'add-file',
                         hash,
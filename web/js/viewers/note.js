@@ -131,10 +131,13 @@ function Note(parentList, item)
     item.controller = self;
     item.container = self.container;
     
-    var tokens = parseNote(item.content);
+    // Content is rendered when the note comes near the viewport,
+    // see NoteList.observe() and materialize().
     var contentElement = self.container.find('.note-content');
-    renderNote(tokens, contentElement, self);
     self.contentElement = contentElement;
+    self.materialized = false;
+    self.fragment = null;
+    contentElement.style.minHeight = estimateNoteHeight(item.content) + 'px';
 
     var label = self.container.find('.note-label');
     label.textContent = item.hash ? item.hash.substring(0,8) : _t("New");
@@ -158,7 +161,9 @@ function Note(parentList, item)
             el.classList.remove('note-edited');
     	    el.setAttribute('contenteditable', false);
             el.classList.remove('editing');
-            renderNote(parseNote(item.content), contentElement, self);
+            self.materialized = false;
+            self.fragment = null;
+            self.materialize();
             viewer.didNoteChange();
             self.refreshActionBar();
         }
@@ -176,6 +181,9 @@ function Note(parentList, item)
 
     self.setCurrentContent = function(text) {
         var el = contentElement;
+        self.materialized = true;
+        self.fragment = null;
+        el.style.minHeight = '';
         if (self.isEditing()) {
             el.empty();
             var t = document.createElement('span');
@@ -287,6 +295,48 @@ function Note(parentList, item)
     };
 }
 
+// Rough height of a note before it is rendered, so that the
+// scroll position stays close to the final one.
+function estimateNoteHeight(text)
+{
+    var lines = 1;
+    text.split("\n").forEach(function(x) {
+        lines += Math.floor(x.length / 80) + 1;
+    });
+    return Math.min(lines, 30) * 20;
+}
+
+// Render the content, or put back what release() took away
+// if the revision is still the same.
+Note.prototype.materialize = function() {
+    if (this.materialized)
+        return;
+    var el = this.contentElement;
+    this.materialized = true;
+    if (this.fragment && this.fragmentRev == this.item.revhash) {
+        el.appendChild(this.fragment);
+    } else {
+        renderNote(parseNoteCached(this.item.revhash, this.item.content), el, this);
+    }
+    this.fragment = null;
+    el.style.minHeight = '';
+};
+
+// Take the rendered content out of the document when the note is
+// far away from the viewport. The nodes are kept for materialize().
+Note.prototype.release = function() {
+    if (!this.materialized || this.isEditing() || this.item.newContent)
+        return;
+    var el = this.contentElement;
+    el.style.minHeight = el.offsetHeight + 'px';
+    var f = document.createDocumentFragment();
+    while (el.firstChild)
+        f.appendChild(el.firstChild);
+    this.fragment = f;
+    this.fragmentRev = this.item.revhash;
+    this.materialized = false;
+};
+
 Note.prototype.getSelectedRange = function() {
     var note = this;
     var range = null;
@@ -404,6 +454,68 @@ function NoteList (v)
     container.className = "list-container";
     self.container = container;
     self.notes = [];
+
+    // Only notes within this distance of the visible area are rendered
+    const MATERIALIZE_MARGIN = '1500px';
+    var observer = null;
+
+    function findScroller(el) {
+        for (; el && el != document.body; el = el.parentElement) {
+            var t = getComputedStyle(el).overflowY;
+            if (t == 'auto' || t == 'scroll')
+                return el;
+        }
+        return null;
+    }
+
+    function didIntersect(entries) {
+        entries.forEach(function(e) {
+            var note = e.target.controller;
+            if (e.isIntersecting)
+                note.materialize();
+            else
+                note.release();
+        });
+    }
+
+    // The scroller is only known once the list is in the page, which
+    // it may not be yet when the first notes are added. Those wait,
+    // a frame at a time, and are shown as they are if it takes long.
+    var waiting = [];
+    function observeLater(note, frames) {
+        waiting.push(note);
+        if (waiting.length > 1)
+            return;
+        (function retry(n) {
+            if (!container.isConnected && n > 0) {
+                requestAnimationFrame(function() { retry(n - 1); });
+                return;
+            }
+            var u = waiting;
+            waiting = [];
+            u.forEach(container.isConnected ? self.observe : function(x) {
+                x.materialize();
+            });
+        })(frames);
+    }
+
+    self.observe = function(note) {
+        if (!window.IntersectionObserver) {
+            note.materialize();
+            return;
+        }
+        if (!observer) {
+            if (!container.isConnected) {
+                observeLater(note, 120);
+                return;
+            }
+            observer = new IntersectionObserver(didIntersect, {
+                root: findScroller(container.parentElement),
+                rootMargin: MATERIALIZE_MARGIN + ' 0px'
+            });
+        }
+        observer.observe(note.container);
+    };
     
     /* ------------------------------------------------------------ */
     self.saveNotes = function() {
@@ -422,7 +534,7 @@ function NoteList (v)
             mux.request('space!', [
                 "update-note",
                 note.hash,
-                "",
+                note.revhash,
                 note.newContent
             ], function(r) {
                 didSaveNote(note,r,false);
@@ -478,6 +590,7 @@ function NoteList (v)
     function addNote(item) {
         var note = new Note(self, item);
         container.appendChild(note.container);
+        self.observe(note);
         return note;
     }
 
@@ -1200,7 +1313,7 @@ function createStandAloneNote(v, noteId)
     el.className = "note-content";
     v.space.mux.request('space', ['get-note', noteId], function(r) {
         if (r.content) {
-            renderNote(parseNote(r.content), el, {viewer:v});
+            renderNote(parseNoteCached(r.revhash, r.content), el, {viewer:v});
         }
     });
     el.onclick = function(e) {
@@ -584,7 +584,9 @@ registerViewer('space-exit', {
                     });
                 });
             } else {
-	        window.location.reload();
+                httpGetSEXP('/api/spaces/lock', {}, function(x) {
+	            window.location.reload();
+                });
             }
 	};
 
@@ -154,19 +154,32 @@ registerViewer('timeline', {
             noteId: v.data.noteId.substring(0,8)
         });
         var elList = vc.find('.list-plain');
-        function loadTimeline(cb) {
+        // Load all logs, 50 at a time
+        var loadSeq = 0;
+        function loadTimeline(cursor) {
+            if (!cursor) {
+                elList.empty();
+                loadSeq++;
+            }
+            var seq = loadSeq;
             v.space.mux.request("space", [
                 "list-logs",
-                v.data.noteId ? v.data.noteId : false
+                v.data.noteId ? v.data.noteId : false,
+                cursor || "",
+                50
             ], function(r) {
-                elList.empty();
-                r.forEach(function(item) {
+                if (r.error) {
+                    app.err(r.error);
+                    return;
+                }
+                if (seq != loadSeq)
+                    return; // reloaded meanwhile
+                r[1].forEach(function(item) {
                     var entry = new NoteLogEntry(v, item);
                     elList.appendChild(entry.view);
                 });
-                if (cb) {
-                    cb();
-                }
+                if (r[2])
+                    loadTimeline(r[2]);
             });
         }
 
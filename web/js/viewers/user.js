@@ -136,6 +136,8 @@ registerViewer('user', {
         var vc = cloneTemplate('tpl-user');
 	var body = vc.querySelector('.user-timeline');
         var loadOffset = 0;
+        var loadCursor = ""; // see Keyset pagination in space-storage.l
+        var loadTotal = 0;
         const loadLimit = 50;
         
         function updateUserInfo() {
@@ -207,6 +209,7 @@ registerViewer('user', {
                 el.classList.add('active');
                 elPrev.classList.remove('active');
                 loadOffset = 0;
+                loadCursor = "";
                 loadNotes();
             }
         };
@@ -224,24 +227,26 @@ registerViewer('user', {
             var type = getListingType();
             if (isCurrentUser) {
                 if (type == 'recent') {
-                    mux.request('space', ["list-recent-notes", 'all', loadOffset, loadLimit], buildNoteList);
+                    mux.request('space', ["list-recent-notes", 'all', loadCursor, loadLimit], buildNoteList);
                     return;
                 }
             }
-            mux.request('space', ["list-user-notes", v.data.uuid, type, loadOffset, loadLimit], buildNoteList);
+            mux.request('space', ["list-user-notes", v.data.uuid, type, loadCursor, loadLimit], buildNoteList);
         }
 
         function buildNoteList(ret) {
-            var total = ret[0];
             var r = ret[1];
-            if (loadOffset == 0)
+            if (loadOffset == 0) {
                 body.empty();
+                loadTotal = ret[0];
+            }
+            loadCursor = ret[2];
             vc.find('#no-notes').hide();
-            if (r.length < loadLimit) {
+            if (!loadCursor) {
                 vc.find('#more-notes').classList.add('collapse');
             } else {
                 vc.find('#more-notes').classList.remove('collapse');
-                vc.find('#more-cnt').textContent = total - loadOffset - r.length;
+                vc.find('#more-cnt').textContent = loadTotal - loadOffset - r.length;
             }
 	    if (!r || r.error) {
 		body.appendChild(createParagraph(r.error?r.error:'Error'));
@@ -270,6 +275,7 @@ registerViewer('user', {
         mux.on('did-update-notes', v, function(uuid) {
             if (!uuid || uuid == v.data.uuid) {
                 loadOffset = 0;
+                loadCursor = "";
                 loadNotes();
             }
         });
@@ -881,13 +887,14 @@ registerViewer('allnotes', {
 	const v = this;
         const vc = cloneTemplate('tpl-all-notes');
 	var loadOffset = 0;
+	var loadCursor = "";
 	var loadLimit = 200;
 	var body = vc.querySelector('.notes');
         var mux = v.space.mux;
 	v.setTitle(_t('All Notes'));
 	v.container.classList.add('fat');
         function loadNotes() {
-            mux.request('space', ["list-recent-notes", 'created', loadOffset, loadLimit], buildNoteList);
+            mux.request('space', ["list-recent-notes", 'created', loadCursor, loadLimit], buildNoteList);
         }
 
 	function buildNoteList(ret) {
@@ -895,9 +902,8 @@ registerViewer('allnotes', {
             var r = ret[1];
             if (loadOffset == 0)
                 body.empty();
-            if (r.length < loadLimit) {
-
-            } else {
+            loadCursor = ret[2];
+            if (loadCursor) {
 		loadOffset += loadLimit;
 		loadNotes();
             }
@@ -28,19 +28,22 @@ function recordVoice()
     navigator.mediaDevices.getUserMedia({
         audio: true
     }).then(function (stream) {
-        if (!recorder) {
-            recorder = new MediaRecorder(stream);
-            recorder.addEventListener('dataavailable',function(e) {
-                console.log("data:", e.data.size);
-                chunks.push(e.data);
-            });
-        }
-        if (recorder && !recording) {
-            recording = true;
-            recorder.start();
-            // recorder.start(1000);
-            console.log("recording...");
-        }
+        // The polyfill records wav, see dynload.js
+        dynload.require(['recorder'], function() {
+            if (!recorder) {
+                recorder = new MediaRecorder(stream);
+                recorder.addEventListener('dataavailable',function(e) {
+                    console.log("data:", e.data.size);
+                    chunks.push(e.data);
+                });
+            }
+            if (recorder && !recording) {
+                recording = true;
+                recorder.start();
+                // recorder.start(1000);
+                console.log("recording...");
+            }
+        }, app.err);
     }).catch(function (e) {
         alert('No live audio input: ' + e);
     });
@@ -2,6 +2,7 @@ locale.strings = {
     'HELP_ROOT': '/locale/zh-CN/',
     "Twinkle Notes": 'Twinkle 笔记',
     'Add branch':'增加分支',
+    'Backup':'备份',
     'Billing':'结算',
     "Me": '我',
     "Friends": '好友',
@@ -20,6 +21,7 @@ locale.strings = {
     'discard':'丢弃',
     'edit':'编辑',
     'Enter new name':'输入新名称',
+    'Passphrase of the archive':'备份文件的密码',
     'exit':'退出',
     'export':'导出',
     'friend':'好友',